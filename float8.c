@@ -1,5 +1,12 @@
 #include "float8.h"
 
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
 /****************************
  * EXPONENT_BIAS DEFINITION *
  ****************************/
@@ -28,6 +35,13 @@
 #define EXPONENT_BIAS 31
 #endif
 
+/*
+ * The number of bits of the float8 fraction and the value
+ * of the float8 exponent used for infinity.
+ */
+#define FRACTION_BITS (7 - EXPONENT_BITS)
+#define INFINITY_EXPONENT ((1 << EXPONENT_BITS) - 1)
+
 /****************************
  * FUNCTION IMPLEMENTATIONS *
  ****************************/
@@ -54,6 +68,8 @@ float8_t increse_by_one(float8_t f8) {
     return uchar_to_float8(temp);
 }
 
+#ifndef FLOAT8_NO_FPU
+
 float8_t float_to_float8(float f) {
     float8_t result;
     uint32_t *p = (uint32_t *)&f;
@@ -572,3 +588,706 @@ float float8_to_float(float8_t f8) {
     // Cast to float to return the correct data type
     return *(float *)&result;
 }
+
+#endif
+
+/****************************
+ * INTEGER-ONLY CONVERSIONS *
+ ****************************/
+
+/*
+ * The following functions implement the conversions of float_to_float8 and
+ * float8_to_float for every float8 format with integer arithmetic only,
+ * for targets without a floating-point unit.
+ */
+
+float8_t float_bits_to_float8(uint32_t bits) {
+    float8_t result;
+
+    // Extract sign, exponent and fraction from the float bit pattern
+    uint32_t sign = (bits >> 31) & 0x1;
+    uint32_t exponent = (bits >> 23) & 0xFF;
+    uint32_t fraction = bits & 0x7FFFFF;
+    int32_t exp_value = (int32_t)exponent - 127;
+
+    // Exponent and fraction of the float8, and the bit used for rounding
+    uint32_t magnitude = 0;
+    uint32_t round = 0;
+
+    if (exponent == 0x0) {  // Zero case (float32 subnormal are zero in float8)
+        magnitude = 0;
+    } else if (exponent == 0xFF || exp_value >= INFINITY_EXPONENT - EXPONENT_BIAS) {  // Infinity case
+        magnitude = (uint32_t)INFINITY_EXPONENT << FRACTION_BITS;
+    } else if (exp_value >= 1 - EXPONENT_BIAS) {  // Normal case
+        magnitude = ((uint32_t)(exp_value + EXPONENT_BIAS) << FRACTION_BITS) | (fraction >> (23 - FRACTION_BITS));
+        round = (fraction >> (22 - FRACTION_BITS)) & 0x01;
+    } else if (exp_value > -EXPONENT_BIAS - FRACTION_BITS) {  // Subnormal case
+        uint32_t shift = 24 - FRACTION_BITS - EXPONENT_BIAS - exp_value;
+        uint32_t significand = fraction | 0x800000;
+        magnitude = significand >> shift;
+        round = (significand >> (shift - 1)) & 0x01;
+    } else if (exp_value == -EXPONENT_BIAS - FRACTION_BITS) {  // Subnormal case (half of the smallest subnormal)
+        magnitude = 0;
+        round = (fraction >> 22) & 0x01;
+    }
+
+    // (Rounding) Increase by one, a carry moves into the exponent
+    magnitude += round;
+
+    result.sign = sign;
+    result.exponent = (magnitude >> FRACTION_BITS) & INFINITY_EXPONENT;
+    result.fraction = magnitude & ((1u << FRACTION_BITS) - 1);
+    return result;
+}
+
+uint32_t float8_to_float_bits(float8_t f8) {
+    uint32_t sign = f8.sign;
+    uint32_t exponent = 0;
+    uint32_t fraction = 0;
+
+    if (f8.exponent == 0x0) {    // Zero or subnormal case
+        if (f8.fraction != 0) {  // Subnormal case
+            // Normalize on the most significant set bit of the fraction
+            int32_t msb = FRACTION_BITS - 1;
+            while (((f8.fraction >> msb) & 0x1) == 0) {
+                msb--;
+            }
+            exponent = (uint32_t)(msb + 1 - FRACTION_BITS - EXPONENT_BIAS + 127);
+            fraction = ((uint32_t)f8.fraction & ((1u << msb) - 1)) << (23 - msb);
+        }
+    } else if (f8.exponent == INFINITY_EXPONENT) {  // Infinity case - No NaN implemented for float8
+        exponent = 0xFF;                            // 1111 1111
+        fraction = 0;
+    } else {  // Normal case
+        exponent = (uint32_t)(f8.exponent - EXPONENT_BIAS + 127);
+        fraction = (uint32_t)f8.fraction << (23 - FRACTION_BITS);
+    }
+
+    // Concatenate the sign, exponent and fraction
+    return (sign << 31) | (exponent << 23) | fraction;
+}
+
+/***********************************
+ * FIXED-POINT INTEGER CONVERSIONS *
+ ***********************************/
+
+float8_t int_to_float8(int32_t value, int frac_bits, int saturate) {
+    uint32_t sign = value < 0;
+    uint32_t magnitude = sign ? 0u - (uint32_t)value : (uint32_t)value;
+    uint32_t result = sign << 31;
+
+    if (magnitude != 0) {
+        // Find the most significant set bit of the magnitude
+        int32_t msb = 31;
+        while (((magnitude >> msb) & 0x1) == 0) {
+            msb--;
+        }
+        // Truncate to the 24 bits of a float32 significand.
+        // The bit used for rounding by float_bits_to_float8 is always kept.
+        uint32_t significand = msb > 23 ? magnitude >> (msb - 23) : magnitude << (23 - msb);
+        result |= ((uint32_t)(msb - frac_bits + 127) << 23) | (significand & 0x7FFFFF);
+    }
+
+    float8_t f8 = float_bits_to_float8(result);
+    if (saturate && f8.exponent == INFINITY_EXPONENT) {  // Overflow case, keep the largest finite value
+        uint32_t max_finite = ((uint32_t)INFINITY_EXPONENT << FRACTION_BITS) - 1;
+        f8.exponent = max_finite >> FRACTION_BITS;
+        f8.fraction = max_finite & ((1u << FRACTION_BITS) - 1);
+    }
+    return f8;
+}
+
+int32_t float8_to_int(float8_t f8, int frac_bits) {
+    uint32_t bits = float8_to_float_bits(f8);
+
+    // Extract sign and exponent from the float bit pattern
+    uint32_t sign = (bits >> 31) & 0x1;
+    int32_t exponent = (bits >> 23) & 0xFF;
+    uint64_t limit = sign ? 0x80000000u : 0x7FFFFFFFu;
+    uint64_t magnitude = 0;
+
+    if (exponent == 0xFF) {  // Infinity case
+        magnitude = limit;
+    } else if (exponent != 0) {
+        uint64_t significand = (bits & 0x7FFFFF) | 0x800000;
+        int32_t shift = exponent - 150 + frac_bits;
+        if (shift > 8) {  // Overflow case
+            magnitude = limit;
+        } else if (shift >= 0) {
+            magnitude = significand << shift;
+        } else if (shift > -32) {
+            // (Rounding) Half away from zero
+            magnitude = (significand + ((uint64_t)1 << (-shift - 1))) >> -shift;
+        }
+        if (magnitude > limit) {
+            magnitude = limit;
+        }
+    }
+
+    return sign ? (int32_t)(0u - (uint32_t)magnitude) : (int32_t)magnitude;
+}
+
+/*
+ * Saturate a 32-bit integer to the range [min, max].
+ */
+static int32_t saturate(int32_t value, int32_t min, int32_t max) {
+    return value < min ? min : (value > max ? max : value);
+}
+
+/*
+ * Fill a lookup table with the fixed-point value of every float8 number.
+ * The table is indexed by the unsigned char representation of the float8.
+ */
+static void fill_int_table(int32_t table[256], int frac_bits) {
+    for (int i = 0; i < 256; i++) {
+        table[i] = float8_to_int(uchar_to_float8((unsigned char)i), frac_bits);
+    }
+}
+
+void int8_to_float8_array(const int8_t *src, float8_t *dst, size_t n, int frac_bits, int saturate) {
+    float8_t table[256];
+    if (n < 256) {  // Too short to amortize the table
+        for (size_t i = 0; i < n; i++) dst[i] = int_to_float8(src[i], frac_bits, saturate);
+        return;
+    }
+    for (int i = -128; i < 128; i++) table[(uint8_t)i] = int_to_float8(i, frac_bits, saturate);
+    for (size_t i = 0; i < n; i++) dst[i] = table[(uint8_t)src[i]];
+}
+
+void uint8_to_float8_array(const uint8_t *src, float8_t *dst, size_t n, int frac_bits, int saturate) {
+    float8_t table[256];
+    if (n < 256) {  // Too short to amortize the table
+        for (size_t i = 0; i < n; i++) dst[i] = int_to_float8(src[i], frac_bits, saturate);
+        return;
+    }
+    for (int i = 0; i < 256; i++) table[i] = int_to_float8(i, frac_bits, saturate);
+    for (size_t i = 0; i < n; i++) dst[i] = table[src[i]];
+}
+
+void int16_to_float8_array(const int16_t *src, float8_t *dst, size_t n, int frac_bits, int saturate) {
+    for (size_t i = 0; i < n; i++) dst[i] = int_to_float8(src[i], frac_bits, saturate);
+}
+
+void int32_to_float8_array(const int32_t *src, float8_t *dst, size_t n, int frac_bits, int saturate) {
+    for (size_t i = 0; i < n; i++) dst[i] = int_to_float8(src[i], frac_bits, saturate);
+}
+
+void float8_to_int8_array(const float8_t *src, int8_t *dst, size_t n, int frac_bits) {
+    int32_t table[256];
+    fill_int_table(table, frac_bits);
+    for (size_t i = 0; i < n; i++) {
+        dst[i] = (int8_t)saturate(table[float8_to_uchar(src[i])], INT8_MIN, INT8_MAX);
+    }
+}
+
+void float8_to_uint8_array(const float8_t *src, uint8_t *dst, size_t n, int frac_bits) {
+    int32_t table[256];
+    fill_int_table(table, frac_bits);
+    for (size_t i = 0; i < n; i++) {
+        dst[i] = (uint8_t)saturate(table[float8_to_uchar(src[i])], 0, UINT8_MAX);
+    }
+}
+
+void float8_to_int16_array(const float8_t *src, int16_t *dst, size_t n, int frac_bits) {
+    int32_t table[256];
+    fill_int_table(table, frac_bits);
+    for (size_t i = 0; i < n; i++) {
+        dst[i] = (int16_t)saturate(table[float8_to_uchar(src[i])], INT16_MIN, INT16_MAX);
+    }
+}
+
+void float8_to_int32_array(const float8_t *src, int32_t *dst, size_t n, int frac_bits) {
+    int32_t table[256];
+    fill_int_table(table, frac_bits);
+    for (size_t i = 0; i < n; i++) dst[i] = table[float8_to_uchar(src[i])];
+}
+
+#ifndef FLOAT8_NO_FPU
+
+/*******************************
+ * LAZY FLOAT32 VIEW OF FLOAT8 *
+ *******************************/
+
+void float8_to_float_array(const float8_t *src, float *dst, size_t n) {
+    float table[256];
+    for (int i = 0; i < 256; i++) table[i] = float8_to_float(uchar_to_float8((unsigned char)i));
+    for (size_t i = 0; i < n; i++) dst[i] = table[float8_to_uchar(src[i])];
+}
+
+void float8_view_init(float8_view_t *view, const float8_t *data, size_t length, int prefetch) {
+    view->data = data;
+    view->length = length;
+    view->prefetch = prefetch;
+    for (int i = 0; i < 256; i++) {
+        view->table[i] = float8_to_float(uchar_to_float8((unsigned char)i));
+    }
+    // Tags hold the block number plus one, zero marks an empty cache slot
+    for (int i = 0; i < FLOAT8_VIEW_CACHE_BLOCKS; i++) {
+        view->tags[i] = 0;
+    }
+    view->last_miss = 0;
+    view->decoded_blocks = 0;
+}
+
+/*
+ * Decode a block of a float8 view into its cache slot, if not already cached.
+ *
+ * @param view: float8 view
+ * @param block: number of the block to be decoded
+ * @return: decoded single-precision floating point values of the block
+ */
+static const float *view_load_block(float8_view_t *view, size_t block) {
+    size_t slot = block % FLOAT8_VIEW_CACHE_BLOCKS;
+    float *values = view->blocks[slot];
+    if (view->tags[slot] != block + 1) {
+        size_t start = block * FLOAT8_VIEW_BLOCK_SIZE;
+        size_t count = view->length - start;
+        if (count > FLOAT8_VIEW_BLOCK_SIZE) count = FLOAT8_VIEW_BLOCK_SIZE;
+        for (size_t i = 0; i < count; i++) {
+            values[i] = view->table[float8_to_uchar(view->data[start + i])];
+        }
+        view->tags[slot] = block + 1;
+        view->decoded_blocks++;
+    }
+    return values;
+}
+
+/*
+ * Hint the processor to load the memory at an address into the cache.
+ * Without a compiler builtin the hint is dropped.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define PREFETCH(address) __builtin_prefetch(address)
+#else
+#define PREFETCH(address) ((void)(address))
+#endif
+
+/*
+ * The number of blocks ahead of a sequential scan whose float8 data is prefetched.
+ */
+#define VIEW_PREFETCH_DISTANCE 2
+
+size_t float8_view_span(float8_view_t *view, size_t index, const float **span) {
+    size_t block = index / FLOAT8_VIEW_BLOCK_SIZE;
+    size_t offset = index % FLOAT8_VIEW_BLOCK_SIZE;
+    size_t slot = block % FLOAT8_VIEW_CACHE_BLOCKS;
+
+    if (view->tags[slot] != block + 1) {
+        // (Prefetch) The previous miss was on the preceding block, so a sequential
+        // scan is likely: start loading the float8 data of the blocks ahead
+        size_t ahead = (block + VIEW_PREFETCH_DISTANCE) * FLOAT8_VIEW_BLOCK_SIZE;
+        if (view->prefetch && view->last_miss == block && ahead < view->length) {
+            PREFETCH(view->data + ahead);
+        }
+        view->last_miss = block + 1;
+    }
+    *span = view_load_block(view, block) + offset;
+
+    size_t count = view->length - index;
+    if (count > FLOAT8_VIEW_BLOCK_SIZE - offset) count = FLOAT8_VIEW_BLOCK_SIZE - offset;
+    return count;
+}
+
+float float8_view_get(float8_view_t *view, size_t index) {
+    const float *span;
+    float8_view_span(view, index, &span);
+    return *span;
+}
+
+/**********************************************
+ * ERROR-DIFFUSION (SIGMA-DELTA) QUANTIZATION *
+ **********************************************/
+
+int float8_sd_init(float8_sd_state_t *state, float *residual, size_t channels) {
+    state->residual = residual;
+    state->channels = channels;
+    state->channel = 0;
+    for (size_t c = 0; c < channels; c++) {
+        residual[c] = 0;
+    }
+    return channels == 0 ? -1 : 0;
+}
+
+/*
+ * Scale factor that maps the float8 subnormal range to [0, 2^FRACTION_BITS),
+ * i.e. the inverse of the value of the smallest float8 subnormal.
+ */
+#define SUBNORMAL_SCALE ((float)(1u << (EXPONENT_BIAS + FRACTION_BITS - 1)))
+
+/*
+ * Quantize a single sample and update the residual of its channel.
+ *
+ * This is the float_bits_to_float8 and float8_to_float_bits conversion written
+ * as straight-line code: every case is computed and the result is picked
+ * with bit masks, so that a loop over independent channels can be vectorized.
+ * Subnormal float8 values are handled with float arithmetic, which avoids
+ * shifts by a variable amount. The results are bit-exact with float_to_float8.
+ *
+ * @param residual: residual of the channel of the sample
+ * @param f: sample to be converted
+ * @return: unsigned char representation of the 8-bit minifloat (float8_t) number
+ */
+static unsigned char sd_quantize(float *residual, float f) {
+    float value = f + *residual;
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    // Extract sign, exponent and fraction from the float
+    uint32_t sign = bits >> 31;
+    uint32_t abs_bits = bits & 0x7FFFFFFF;
+    int32_t exp_value = (int32_t)((bits >> 23) & 0xFF) - 127;
+    uint32_t fraction = bits & 0x7FFFFF;
+
+    // Masks of the float8 cases (float32 zero, subnormal and NaN fall in the other cases)
+    uint32_t is_infinity = 0u - (uint32_t)(exp_value >= INFINITY_EXPONENT - EXPONENT_BIAS);
+    uint32_t is_normal = 0u - (uint32_t)(exp_value >= 1 - EXPONENT_BIAS);
+    uint32_t is_half = 0u - (uint32_t)(exp_value == -EXPONENT_BIAS - FRACTION_BITS);
+
+    // Normal case, with the (Rounding) increase by one
+    uint32_t normal = (((uint32_t)(exp_value + EXPONENT_BIAS) << FRACTION_BITS) | (fraction >> (23 - FRACTION_BITS))) +
+                      ((fraction >> (22 - FRACTION_BITS)) & 0x01);
+
+    // Subnormal case, scale to units of the smallest subnormal and truncate
+    float scaled;
+    memcpy(&scaled, &abs_bits, sizeof(scaled));
+    scaled *= SUBNORMAL_SCALE;
+    // Limit to 2^FRACTION_BITS (also infinity and NaN, which are masked out)
+    uint32_t scaled_bits;
+    memcpy(&scaled_bits, &scaled, sizeof(scaled_bits));
+    uint32_t limit_bits = (uint32_t)(127 + FRACTION_BITS) << 23;
+    uint32_t in_range = 0u - (uint32_t)(scaled_bits < limit_bits);
+    scaled_bits = (scaled_bits & in_range) | (limit_bits & ~in_range);
+    memcpy(&scaled, &scaled_bits, sizeof(scaled));
+    uint32_t subnormal = (uint32_t)(int32_t)scaled + ((uint32_t)(int32_t)(scaled * 2) & 0x01);
+
+    // Subnormal case (half of the smallest subnormal)
+    uint32_t half = (fraction >> 22) & 0x01;
+
+    uint32_t magnitude = (normal & is_normal) | (subnormal & ~is_normal);
+    magnitude = (half & is_half) | (magnitude & ~is_half);
+    magnitude = (((uint32_t)INFINITY_EXPONENT << FRACTION_BITS) & is_infinity) | (magnitude & ~is_infinity);
+
+    // Decode the float8 number back to float
+    uint32_t f8_exponent = magnitude >> FRACTION_BITS;
+    uint32_t f8_fraction = magnitude & ((1u << FRACTION_BITS) - 1);
+    uint32_t normal_bits = (sign << 31) | ((f8_exponent - EXPONENT_BIAS + 127) << 23) |
+                           (f8_fraction << (23 - FRACTION_BITS));
+    float subnormal_value = (float)(int32_t)f8_fraction / SUBNORMAL_SCALE;
+    uint32_t subnormal_bits;
+    memcpy(&subnormal_bits, &subnormal_value, sizeof(subnormal_bits));
+    subnormal_bits |= sign << 31;
+    uint32_t is_subnormal = 0u - (uint32_t)(f8_exponent == 0);
+    uint32_t decoded_bits = (subnormal_bits & is_subnormal) | (normal_bits & ~is_subnormal);
+    float decoded;
+    memcpy(&decoded, &decoded_bits, sizeof(decoded));
+
+    // No finite error to carry from infinity
+    float error = value - decoded;
+    uint32_t error_bits;
+    memcpy(&error_bits, &error, sizeof(error_bits));
+    error_bits &= ~(0u - (uint32_t)(f8_exponent == INFINITY_EXPONENT));
+    memcpy(&error, &error_bits, sizeof(error));
+    *residual = error;
+
+    return (unsigned char)((sign << 7) | magnitude);
+}
+
+void float_to_float8_sd(float8_sd_state_t *state, const float *src, float8_t *dst, size_t n) {
+    // Store through the unsigned char representation (see float8_to_uchar)
+    unsigned char *out = (unsigned char *)dst;
+    float *residual = state->residual;
+    size_t channels = state->channels;
+    size_t channel = state->channel;
+    size_t i = 0;
+
+    // A stream without channels has no frames
+    if (channels == 0) return;
+
+    // Finish the frame left incomplete by the previous call
+    while (i < n && channel != 0) {
+        out[i] = sd_quantize(&residual[channel], src[i]);
+        i++;
+        channel = (channel + 1) % channels;
+    }
+    // Whole frames, the channels of a frame are independent of each other
+    // and are quantized in parallel lanes when the loop is vectorized
+    while (n - i >= channels) {
+        for (size_t c = 0; c < channels; c++) {
+            out[i + c] = sd_quantize(&residual[c], src[i + c]);
+        }
+        i += channels;
+    }
+    // Start of an incomplete frame
+    while (i < n) {
+        out[i] = sd_quantize(&residual[channel], src[i]);
+        i++;
+        channel++;
+    }
+    state->channel = channel;
+}
+
+#endif
+
+/*************************
+ * ALIGNED BUFFER ARENAS *
+ *************************/
+
+/*
+ * The size (in bytes) of a transparent huge page.
+ */
+#define HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+int float8_arena_init(float8_arena_t *arena, size_t capacity, int flags) {
+    // Arenas smaller than a huge page cannot be backed by one, so they are not aligned to it
+    if (capacity < HUGE_PAGE_SIZE) flags &= ~FLOAT8_ARENA_HUGEPAGES;
+    size_t alignment = (flags & FLOAT8_ARENA_HUGEPAGES) ? HUGE_PAGE_SIZE : FLOAT8_ALIGNMENT;
+
+    // Round the capacity up to whole buffers
+    capacity = (capacity + FLOAT8_ALIGNMENT - 1) / FLOAT8_ALIGNMENT * FLOAT8_ALIGNMENT;
+    if (capacity > SIZE_MAX - alignment) return -1;
+
+    // Reserve enough memory to align the start of the arena
+    arena->memory = malloc(capacity + alignment);
+    if (arena->memory == NULL) return -1;
+    uintptr_t address = (uintptr_t)arena->memory;
+    arena->start = (unsigned char *)arena->memory + (alignment - address % alignment) % alignment;
+    arena->capacity = capacity;
+    arena->offset = 0;
+    memset(&arena->stats, 0, sizeof(arena->stats));
+
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    if (flags & FLOAT8_ARENA_HUGEPAGES) {
+        // Only the whole huge pages of the arena can be backed by huge pages
+        size_t length = capacity / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+        madvise(arena->start, length, MADV_HUGEPAGE);
+    }
+#endif
+
+    if (flags & FLOAT8_ARENA_PREFAULT) {
+        // Touch every page now instead of on the first conversion
+        memset(arena->start, 0, capacity);
+    }
+    return 0;
+}
+
+void *float8_arena_alloc(float8_arena_t *arena, size_t size) {
+    // An empty buffer would share its address with the next buffer
+    if (size == 0) return NULL;
+    if (size > arena->capacity - arena->offset) {
+        arena->stats.failures++;
+        return NULL;
+    }
+    // Pad the buffer so the next one stays aligned
+    size_t padded = (size + FLOAT8_ALIGNMENT - 1) / FLOAT8_ALIGNMENT * FLOAT8_ALIGNMENT;
+    void *buffer = arena->start + arena->offset;
+    arena->offset += padded;
+
+    arena->stats.allocations++;
+    arena->stats.bytes_in_use = arena->offset;
+    if (arena->stats.peak_bytes_in_use < arena->offset) {
+        arena->stats.peak_bytes_in_use = arena->offset;
+    }
+    return buffer;
+}
+
+float8_t *float8_arena_alloc_float8(float8_arena_t *arena, size_t n) {
+    size_t size = n > SIZE_MAX / sizeof(float8_t) ? SIZE_MAX : n * sizeof(float8_t);
+    return (float8_t *)float8_arena_alloc(arena, size);
+}
+
+float *float8_arena_alloc_float(float8_arena_t *arena, size_t n) {
+    size_t size = n > SIZE_MAX / sizeof(float) ? SIZE_MAX : n * sizeof(float);
+    return (float *)float8_arena_alloc(arena, size);
+}
+
+void float8_arena_reset(float8_arena_t *arena) {
+    arena->offset = 0;
+    arena->stats.resets++;
+    arena->stats.bytes_in_use = 0;
+}
+
+void float8_arena_destroy(float8_arena_t *arena) {
+    free(arena->memory);
+    arena->memory = NULL;
+    arena->start = NULL;
+    arena->capacity = 0;
+    arena->offset = 0;
+}
+
+/*******************
+ * OCP FP8 FORMATS *
+ *******************/
+
+/*
+ * Shift a value right, rounding to nearest, ties to even.
+ *
+ * @param value: value to be shifted
+ * @param shift: number of bits to drop (1 to 31)
+ * @return: rounded value
+ */
+static uint32_t round_shift(uint32_t value, uint32_t shift) {
+    return (value + (1u << (shift - 1)) - 1 + ((value >> shift) & 0x1)) >> shift;
+}
+
+/*
+ * Convert the bit pattern of a float to an OCP FP8 number.
+ * Every case is computed and the result is picked with bit masks, so the
+ * conversion has no branches and loops over it can be vectorized.
+ * Supports formats with up to 3 fraction bits (E4M3FN and E5M2).
+ *
+ * @param bits: bit pattern of the single-precision floating point number
+ * @param exponent_bits: number of exponent bits of the FP8 format
+ * @param bias: exponent bias of the FP8 format
+ * @param max_finite: code of the largest finite value
+ * @param overflow: code used for overflow when not saturating
+ * @param nan: code of NaN
+ * @param saturate: FLOAT8_SATURATE or FLOAT8_OVERFLOW
+ * @return: FP8 number
+ */
+static uint8_t ocp_encode(uint32_t bits, uint32_t exponent_bits, uint32_t bias, uint32_t max_finite,
+                          uint32_t overflow, uint32_t nan, int saturate) {
+    uint32_t sign = (bits >> 24) & 0x80;
+    uint32_t abs = bits & 0x7FFFFFFF;
+    uint32_t fraction_bits = 7 - exponent_bits;
+    uint32_t exponent = abs >> 23;
+
+    // Normal case (also infinity), rebias the exponent and round the extra fraction bits.
+    // A carry moves into the exponent.
+    uint32_t normal = round_shift(abs - ((127 - bias) << 23), 23 - fraction_bits);
+
+    // Subnormal case, one constant shift for each exponent below the normal range.
+    // Smaller exponents (also float32 subnormal) round to zero.
+    uint32_t significand = (abs & 0x7FFFFF) | 0x800000;
+    uint32_t subnormal = (round_shift(significand, 24 - fraction_bits) & (0u - (uint32_t)(exponent == 127 - bias))) |
+                         (round_shift(significand, 25 - fraction_bits) & (0u - (uint32_t)(exponent == 126 - bias))) |
+                         (round_shift(significand, 26 - fraction_bits) & (0u - (uint32_t)(exponent == 125 - bias))) |
+                         (round_shift(significand, 27 - fraction_bits) & (0u - (uint32_t)(exponent == 124 - bias)));
+
+    uint32_t is_normal = 0u - (uint32_t)(exponent >= 128 - bias);
+    uint32_t code = (normal & is_normal) | (subnormal & ~is_normal);
+
+    // Overflow (also infinity) case
+    uint32_t is_saturating = 0u - (uint32_t)(saturate != 0);
+    uint32_t overflow_code = (max_finite & is_saturating) | (overflow & ~is_saturating);
+    uint32_t is_overflow = 0u - (uint32_t)(code > max_finite);
+    code = (overflow_code & is_overflow) | (code & ~is_overflow);
+
+    // NaN case
+    uint32_t is_nan = 0u - (uint32_t)(abs > 0x7F800000);
+    code = (nan & is_nan) | (code & ~is_nan);
+    return (uint8_t)(sign | code);
+}
+
+/*
+ * Convert an OCP FP8 number to the bit pattern of a float.
+ *
+ * @param v: FP8 number to be converted
+ * @param exponent_bits: number of exponent bits of the FP8 format
+ * @param bias: exponent bias of the FP8 format
+ * @param ieee_specials: non-zero if the all-ones exponent encodes infinity
+ *                       and NaN (E5M2), zero if only the all-ones code is NaN (E4M3FN)
+ * @return: bit pattern of the single-precision floating point number
+ */
+static uint32_t ocp_decode(uint8_t v, uint32_t exponent_bits, uint32_t bias, int ieee_specials) {
+    uint32_t fraction_bits = 7 - exponent_bits;
+    uint32_t sign = (uint32_t)(v >> 7) << 31;
+    uint32_t f8_exponent = (v & 0x7F) >> fraction_bits;
+    uint32_t f8_fraction = v & ((1u << fraction_bits) - 1);
+    uint32_t all_ones = (1u << exponent_bits) - 1;
+    uint32_t exponent = 0;
+    uint32_t fraction = 0;
+
+    if ((v & 0x7F) == 0x7F || (ieee_specials && f8_exponent == all_ones && f8_fraction != 0)) {  // NaN case
+        exponent = 0xFF;
+        fraction = 0x400000;  // Quiet NaN
+    } else if (ieee_specials && f8_exponent == all_ones) {  // Infinity case
+        exponent = 0xFF;
+    } else if (f8_exponent == 0x0) {  // Zero or subnormal case
+        if (f8_fraction != 0) {        // Subnormal case
+            // Normalize on the most significant set bit of the fraction
+            uint32_t msb = fraction_bits - 1;
+            while (((f8_fraction >> msb) & 0x1) == 0) {
+                msb--;
+            }
+            exponent = msb + 1 - fraction_bits - bias + 127;
+            fraction = (f8_fraction & ((1u << msb) - 1)) << (23 - msb);
+        }
+    } else {  // Normal case
+        exponent = f8_exponent - bias + 127;
+        fraction = f8_fraction << (23 - fraction_bits);
+    }
+
+    return sign | (exponent << 23) | fraction;
+}
+
+uint8_t float_bits_to_e4m3fn(uint32_t bits, int saturate) {
+    // Largest finite S.1111.110 (448), overflow and NaN S.1111.111
+    return ocp_encode(bits, 4, 7, 0x7E, 0x7F, 0x7F, saturate);
+}
+
+uint8_t float_bits_to_e5m2(uint32_t bits, int saturate) {
+    // Largest finite S.11110.11 (57344), overflow S.11111.00 (infinity), NaN S.11111.10
+    return ocp_encode(bits, 5, 15, 0x7B, 0x7C, 0x7E, saturate);
+}
+
+uint32_t e4m3fn_to_float_bits(uint8_t e4m3) { return ocp_decode(e4m3, 4, 7, 0); }
+
+uint32_t e5m2_to_float_bits(uint8_t e5m2) { return ocp_decode(e5m2, 5, 15, 1); }
+
+#ifndef FLOAT8_NO_FPU
+
+uint8_t float_to_e4m3fn(float f, int saturate) {
+    uint32_t bits;
+    memcpy(&bits, &f, sizeof(bits));
+    return float_bits_to_e4m3fn(bits, saturate);
+}
+
+uint8_t float_to_e5m2(float f, int saturate) {
+    uint32_t bits;
+    memcpy(&bits, &f, sizeof(bits));
+    return float_bits_to_e5m2(bits, saturate);
+}
+
+float e4m3fn_to_float(uint8_t e4m3) {
+    uint32_t bits = e4m3fn_to_float_bits(e4m3);
+    float result;
+    memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+float e5m2_to_float(uint8_t e5m2) {
+    uint32_t bits = e5m2_to_float_bits(e5m2);
+    float result;
+    memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+void float_to_e4m3fn_array(const float *src, uint8_t *dst, size_t n, int saturate) {
+    for (size_t i = 0; i < n; i++) {
+        uint32_t bits;
+        memcpy(&bits, &src[i], sizeof(bits));
+        dst[i] = float_bits_to_e4m3fn(bits, saturate);
+    }
+}
+
+void float_to_e5m2_array(const float *src, uint8_t *dst, size_t n, int saturate) {
+    for (size_t i = 0; i < n; i++) {
+        uint32_t bits;
+        memcpy(&bits, &src[i], sizeof(bits));
+        dst[i] = float_bits_to_e5m2(bits, saturate);
+    }
+}
+
+void e4m3fn_to_float_array(const uint8_t *src, float *dst, size_t n) {
+    float table[256];
+    for (int i = 0; i < 256; i++) table[i] = e4m3fn_to_float((uint8_t)i);
+    for (size_t i = 0; i < n; i++) dst[i] = table[src[i]];
+}
+
+void e5m2_to_float_array(const uint8_t *src, float *dst, size_t n) {
+    float table[256];
+    for (int i = 0; i < 256; i++) table[i] = e5m2_to_float((uint8_t)i);
+    for (size_t i = 0; i < n; i++) dst[i] = table[src[i]];
+}
+
+#endif
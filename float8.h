@@ -1,6 +1,7 @@
 #ifndef FLOAT8_H
 #define FLOAT8_H
 
+#include <stddef.h>
 #include <stdint.h>
 
 /***********************************************************
@@ -8,6 +9,47 @@
  ***********************************************************/
 #define EXPONENT_BITS 4
 
+/***********************************************************
+ * Define FLOAT8_NO_FPU (e.g. -DFLOAT8_NO_FPU) to build the library
+ * for targets without a floating-point unit. Only the functions that
+ * use integer arithmetic are then available.
+ ***********************************************************/
+
+/***********************************************************
+ * The number of float8 values decoded at once by a float8_view_t
+ * and the number of decoded blocks it keeps cached.
+ ***********************************************************/
+#define FLOAT8_VIEW_BLOCK_SIZE 64
+#define FLOAT8_VIEW_CACHE_BLOCKS 4
+
+/***********************************************************
+ * The alignment (in bytes) of the buffers handed out by a float8_arena_t.
+ * Every buffer is also padded to a multiple of this size.
+ ***********************************************************/
+#define FLOAT8_ALIGNMENT 64
+
+/*
+ * Flags of the float8_arena_init function.
+ * FLOAT8_ARENA_PREFAULT touches every page of the arena on initialization.
+ * FLOAT8_ARENA_HUGEPAGES requests transparent huge pages (Linux only). It is
+ * ignored for arenas smaller than a huge page (2 MB), which are only aligned
+ * to FLOAT8_ALIGNMENT bytes.
+ */
+#define FLOAT8_ARENA_PREFAULT 0x1
+#define FLOAT8_ARENA_HUGEPAGES 0x2
+
+/*
+ * Overflow modes of the encoders taking a saturate argument.
+ * FLOAT8_SATURATE maps overflow and infinity to the largest finite value.
+ * FLOAT8_OVERFLOW keeps the overflow value of the format.
+ */
+#define FLOAT8_OVERFLOW 0
+#define FLOAT8_SATURATE 1
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 /*
  * This is the 8-bit minifloat representation.
  * The float8_t struct is used to represent a float8 number.
@@ -21,6 +63,67 @@ typedef struct {
     uint8_t sign : 1;
 } float8_t;
 
+#ifndef FLOAT8_NO_FPU
+
+/*
+ * A lazy float32 view of a float8_t array.
+ * Values are decoded on demand, one block of FLOAT8_VIEW_BLOCK_SIZE
+ * values at a time, into a small direct-mapped cache of blocks.
+ * decoded_blocks counts the blocks decoded since initialization.
+ * The view does not own the float8 data and must not be shared between threads.
+ */
+typedef struct {
+    const float8_t *data;
+    size_t length;
+    int prefetch;
+    float table[256];
+    size_t tags[FLOAT8_VIEW_CACHE_BLOCKS];
+    size_t last_miss;
+    size_t decoded_blocks;
+    float blocks[FLOAT8_VIEW_CACHE_BLOCKS][FLOAT8_VIEW_BLOCK_SIZE];
+} float8_view_t;
+
+/*
+ * The streaming state of an error-diffusion (sigma-delta) quantizer.
+ * It holds the quantization residual of every channel of an interleaved
+ * stream and the channel of the next sample, so that a stream can be
+ * converted in chunks of any size.
+ */
+typedef struct {
+    float *residual;
+    size_t channels;
+    size_t channel;
+} float8_sd_state_t;
+
+#endif
+
+/*
+ * Allocation statistics of a float8_arena_t.
+ */
+typedef struct {
+    size_t allocations;        // Successful allocations
+    size_t failures;           // Allocations that did not fit in the arena
+    size_t resets;             // Calls to float8_arena_reset
+    size_t bytes_in_use;       // Bytes handed out since the last reset, including padding
+    size_t peak_bytes_in_use;  // Largest value of bytes_in_use
+} float8_arena_stats_t;
+
+/*
+ * A fixed-capacity arena of aligned and padded float8 and float32 buffers.
+ * All the buffers of an arena are released together by float8_arena_reset,
+ * so the same memory is reused across conversions without malloc/free churn.
+ * An arena must not be shared between threads, use one arena per thread.
+ */
+typedef struct {
+    void *memory;
+    unsigned char *start;
+    size_t capacity;
+    size_t offset;
+    float8_arena_stats_t stats;
+} float8_arena_t;
+
+#ifndef FLOAT8_NO_FPU
+
 /* Convert a number from single-precision floating point
  * number to 8-bit minifloat (float8_t) number.
  *
@@ -37,6 +140,8 @@ float8_t float_to_float8(float f);
  */
 float float8_to_float(float8_t f8);
 
+#endif
+
 /* Convert an unsigned char to a float8_t.
  * WARNING: type punning violates the strict aliasing rule.
  *
@@ -53,4 +158,323 @@ float8_t uchar_to_float8(unsigned char c);
  */
 unsigned char float8_to_uchar(float8_t f8);
 
+/* Convert the IEEE-754 bit pattern of a single-precision floating point
+ * number to 8-bit minifloat (float8_t) number.
+ * Uses integer arithmetic only. The result is bit-exact with float_to_float8.
+ *
+ * @param bits: bit pattern of the single-precision floating point number
+ * @return: 8-bit minifloat (float8_t) number
+ */
+float8_t float_bits_to_float8(uint32_t bits);
+
+/* Convert a number from 8-bit minifloat (float8_t) number to the IEEE-754
+ * bit pattern of a single-precision floating point number.
+ * Uses integer arithmetic only. The result is bit-exact with float8_to_float.
+ *
+ * @param f8: 8-bit minifloat (float8_t) number to be converted
+ * @return: bit pattern of the single-precision floating point number
+ */
+uint32_t float8_to_float_bits(float8_t f8);
+
+/* Convert a signed fixed-point integer to a float8_t.
+ * The converted value is value * 2^(-frac_bits). Integers wider than
+ * 24 bits are converted without an intermediate float32 rounding step.
+ * Rounding follows the float_to_float8 function. Overflow gives infinity,
+ * or the largest finite float8 number when saturating.
+ * Uses integer arithmetic only.
+ *
+ * @param value: fixed-point integer to be converted
+ * @param frac_bits: number of fractional bits of value (0 to 31)
+ * @param saturate: FLOAT8_SATURATE or FLOAT8_OVERFLOW
+ * @return: 8-bit minifloat (float8_t) number
+ */
+float8_t int_to_float8(int32_t value, int frac_bits, int saturate);
+
+/* Convert a float8_t to a signed fixed-point integer.
+ * The result is f8 * 2^frac_bits rounded half away from zero.
+ * Out of range values and infinity saturate to INT32_MIN / INT32_MAX.
+ * Uses integer arithmetic only.
+ *
+ * @param f8: 8-bit minifloat (float8_t) number to be converted
+ * @param frac_bits: number of fractional bits of the result (0 to 31)
+ * @return: fixed-point integer
+ */
+int32_t float8_to_int(float8_t f8, int frac_bits);
+
+/* Convert an array of fixed-point integers to float8_t numbers.
+ * The 8-bit variants are table driven. The int_to_float8 function
+ * is used for every element.
+ *
+ * @param src: array of fixed-point integers to be converted
+ * @param dst: array of n 8-bit minifloat (float8_t) numbers
+ * @param n: number of elements
+ * @param frac_bits: number of fractional bits of the source values (0 to 31)
+ * @param saturate: FLOAT8_SATURATE or FLOAT8_OVERFLOW
+ */
+void int8_to_float8_array(const int8_t *src, float8_t *dst, size_t n, int frac_bits, int saturate);
+void uint8_to_float8_array(const uint8_t *src, float8_t *dst, size_t n, int frac_bits, int saturate);
+void int16_to_float8_array(const int16_t *src, float8_t *dst, size_t n, int frac_bits, int saturate);
+void int32_to_float8_array(const int32_t *src, float8_t *dst, size_t n, int frac_bits, int saturate);
+
+/* Convert an array of float8_t numbers to fixed-point integers.
+ * The conversion is table driven. The float8_to_int function is used
+ * for every element and the results saturate to the range of the
+ * destination type.
+ *
+ * @param src: array of 8-bit minifloat (float8_t) numbers to be converted
+ * @param dst: array of n fixed-point integers
+ * @param n: number of elements
+ * @param frac_bits: number of fractional bits of the results (0 to 31)
+ */
+void float8_to_int8_array(const float8_t *src, int8_t *dst, size_t n, int frac_bits);
+void float8_to_uint8_array(const float8_t *src, uint8_t *dst, size_t n, int frac_bits);
+void float8_to_int16_array(const float8_t *src, int16_t *dst, size_t n, int frac_bits);
+void float8_to_int32_array(const float8_t *src, int32_t *dst, size_t n, int frac_bits);
+
+#ifndef FLOAT8_NO_FPU
+
+/* Convert an array of float8_t numbers to single-precision floating point numbers.
+ * The conversion is table driven.
+ *
+ * @param src: array of 8-bit minifloat (float8_t) numbers to be converted
+ * @param dst: array of n single-precision floating point numbers
+ * @param n: number of elements
+ */
+void float8_to_float_array(const float8_t *src, float *dst, size_t n);
+
+/* Initialize a lazy float32 view of a float8_t array.
+ *
+ * @param view: view to be initialized
+ * @param data: array of 8-bit minifloat (float8_t) numbers
+ * @param length: number of elements of data
+ * @param prefetch: when non-zero, sequential scans prefetch the float8 data ahead
+ */
+void float8_view_init(float8_view_t *view, const float8_t *data, size_t length, int prefetch);
+
+/* Get a single value of a float8 view as a single-precision floating point number.
+ *
+ * @param view: float8 view
+ * @param index: index of the value (less than the view length)
+ * @return: single-precision floating point number
+ */
+float float8_view_get(float8_view_t *view, size_t index);
+
+/* Get the decoded values of a float8 view starting from an index.
+ * The returned pointer stays valid until the view is used again.
+ *
+ * @param view: float8 view
+ * @param index: index of the first value (less than the view length)
+ * @param span: set to the decoded single-precision floating point values
+ * @return: number of values available in span (at least 1)
+ */
+size_t float8_view_span(float8_view_t *view, size_t index, const float **span);
+
+/* Initialize the state of an error-diffusion quantizer.
+ * The residual array is owned by the caller and must outlive the state.
+ * A state initialized with zero channels is rejected and converts nothing.
+ *
+ * @param state: quantizer state to be initialized
+ * @param residual: array of one residual per channel
+ * @param channels: number of interleaved channels, at least 1 (1 for a plain stream)
+ * @return: 0 on success, -1 if channels is 0
+ */
+int float8_sd_init(float8_sd_state_t *state, float *residual, size_t channels);
+
+/* Convert an interleaved stream of single-precision floating point numbers
+ * to float8_t numbers with error diffusion. The rounding error of every
+ * sample is added to the next sample of the same channel, so the sum of
+ * the converted values follows the sum of the input values.
+ * Converting a stream in chunks gives the same result as a single call.
+ *
+ * @param state: quantizer state
+ * @param src: array of single-precision floating point numbers to be converted
+ * @param dst: array of n 8-bit minifloat (float8_t) numbers
+ * @param n: number of samples
+ */
+void float_to_float8_sd(float8_sd_state_t *state, const float *src, float8_t *dst, size_t n);
+
+#endif
+
+/* Initialize an arena and reserve its memory.
+ *
+ * @param arena: arena to be initialized
+ * @param capacity: number of bytes of the arena
+ * @param flags: combination of the FLOAT8_ARENA_* flags, or 0
+ * @return: 0 on success, -1 if the memory could not be reserved
+ */
+int float8_arena_init(float8_arena_t *arena, size_t capacity, int flags);
+
+/* Allocate a buffer from an arena.
+ * The buffer is aligned to FLOAT8_ALIGNMENT bytes and padded to a
+ * multiple of FLOAT8_ALIGNMENT bytes.
+ *
+ * @param arena: arena to allocate from
+ * @param size: number of bytes of the buffer (at least 1)
+ * @return: the buffer, or NULL if size is 0 or the buffer does not fit in the arena
+ */
+void *float8_arena_alloc(float8_arena_t *arena, size_t size);
+
+/* Allocate an array of n float8_t numbers from an arena.
+ *
+ * @param arena: arena to allocate from
+ * @param n: number of elements (at least 1)
+ * @return: the array, or NULL if n is 0 or the array does not fit in the arena
+ */
+float8_t *float8_arena_alloc_float8(float8_arena_t *arena, size_t n);
+
+/* Allocate an array of n single-precision floating point numbers from an arena.
+ *
+ * @param arena: arena to allocate from
+ * @param n: number of elements (at least 1)
+ * @return: the array, or NULL if n is 0 or the array does not fit in the arena
+ */
+float *float8_arena_alloc_float(float8_arena_t *arena, size_t n);
+
+/* Release all the buffers of an arena, keeping its memory for reuse.
+ *
+ * @param arena: arena to be reset
+ */
+void float8_arena_reset(float8_arena_t *arena);
+
+/* Release the memory of an arena.
+ *
+ * @param arena: arena to be destroyed
+ */
+void float8_arena_destroy(float8_arena_t *arena);
+
+/* Convert the IEEE-754 bit pattern of a single-precision floating point
+ * number to an OCP FP8 E4M3FN number (1-4-3 format, bias 7, no infinity,
+ * NaN encoded as S.1111.111, largest finite value 448).
+ * Rounds to nearest even. NaN inputs give NaN with the input sign.
+ * Uses integer arithmetic only.
+ *
+ * @param bits: bit pattern of the single-precision floating point number
+ * @param saturate: FLOAT8_SATURATE or FLOAT8_OVERFLOW
+ * @return: E4M3FN number
+ */
+uint8_t float_bits_to_e4m3fn(uint32_t bits, int saturate);
+
+/* Convert the IEEE-754 bit pattern of a single-precision floating point
+ * number to an OCP FP8 E5M2 number (1-5-2 format, bias 15, IEEE-754
+ * infinity and NaN, largest finite value 57344).
+ * Rounds to nearest even. NaN inputs give NaN with the input sign.
+ * Uses integer arithmetic only.
+ *
+ * @param bits: bit pattern of the single-precision floating point number
+ * @param saturate: FLOAT8_SATURATE or FLOAT8_OVERFLOW
+ * @return: E5M2 number
+ */
+uint8_t float_bits_to_e5m2(uint32_t bits, int saturate);
+
+/* Convert an OCP FP8 E4M3FN number to the IEEE-754 bit pattern of a
+ * single-precision floating point number. Uses integer arithmetic only.
+ *
+ * @param e4m3: E4M3FN number to be converted
+ * @return: bit pattern of the single-precision floating point number
+ */
+uint32_t e4m3fn_to_float_bits(uint8_t e4m3);
+
+/* Convert an OCP FP8 E5M2 number to the IEEE-754 bit pattern of a
+ * single-precision floating point number. Uses integer arithmetic only.
+ *
+ * @param e5m2: E5M2 number to be converted
+ * @return: bit pattern of the single-precision floating point number
+ */
+uint32_t e5m2_to_float_bits(uint8_t e5m2);
+
+#ifndef FLOAT8_NO_FPU
+
+/* Convert a single-precision floating point number to an OCP FP8 number.
+ * See float_bits_to_e4m3fn and float_bits_to_e5m2.
+ *
+ * @param f: single-precision floating point number to be converted
+ * @param saturate: FLOAT8_SATURATE or FLOAT8_OVERFLOW
+ * @return: E4M3FN or E5M2 number
+ */
+uint8_t float_to_e4m3fn(float f, int saturate);
+uint8_t float_to_e5m2(float f, int saturate);
+
+/* Convert an OCP FP8 number to a single-precision floating point number.
+ *
+ * @param e4m3 / e5m2: E4M3FN or E5M2 number to be converted
+ * @return: single-precision floating point number
+ */
+float e4m3fn_to_float(uint8_t e4m3);
+float e5m2_to_float(uint8_t e5m2);
+
+/* Convert an array of single-precision floating point numbers to OCP FP8 numbers.
+ *
+ * @param src: array of single-precision floating point numbers to be converted
+ * @param dst: array of n E4M3FN or E5M2 numbers
+ * @param n: number of elements
+ * @param saturate: FLOAT8_SATURATE or FLOAT8_OVERFLOW
+ */
+void float_to_e4m3fn_array(const float *src, uint8_t *dst, size_t n, int saturate);
+void float_to_e5m2_array(const float *src, uint8_t *dst, size_t n, int saturate);
+
+/* Convert an array of OCP FP8 numbers to single-precision floating point numbers.
+ * The conversion is table driven.
+ *
+ * @param src: array of E4M3FN or E5M2 numbers to be converted
+ * @param dst: array of n single-precision floating point numbers
+ * @param n: number of elements
+ */
+void e4m3fn_to_float_array(const uint8_t *src, float *dst, size_t n);
+void e5m2_to_float_array(const uint8_t *src, float *dst, size_t n);
+
+#endif
+
+#ifdef __cplusplus
+}
+
+#ifndef FLOAT8_NO_FPU
+
+#include <cstddef>
+#include <iterator>
+
+/*
+ * A C++ range over a float8_view_t, for range-based for loops
+ * and the <algorithm> functions taking input iterators.
+ * Values are decoded lazily through float8_view_get.
+ */
+class float8_view {
+public:
+    class iterator {
+    public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef float value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const float *pointer;
+        typedef float reference;
+
+        iterator(float8_view_t *view, size_t index) : view_(view), index_(index) {}
+
+        float operator*() const { return float8_view_get(view_, index_); }
+        iterator &operator++() { index_++; return *this; }
+        iterator operator++(int) { iterator previous = *this; index_++; return previous; }
+        bool operator==(const iterator &other) const { return index_ == other.index_; }
+        bool operator!=(const iterator &other) const { return index_ != other.index_; }
+
+    private:
+        float8_view_t *view_;
+        size_t index_;
+    };
+
+    float8_view(const float8_t *data, size_t length, int prefetch = 1) {
+        float8_view_init(&view_, data, length, prefetch);
+    }
+
+    iterator begin() { return iterator(&view_, 0); }
+    iterator end() { return iterator(&view_, view_.length); }
+    size_t size() const { return view_.length; }
+    float8_view_t *get() { return &view_; }
+
+private:
+    float8_view_t view_;
+};
+
+#endif
+
+#endif
+
 #endif
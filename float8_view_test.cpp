@@ -0,0 +1,48 @@
+/*
+ * Compile and run check of the C++ float8_view wrapper.
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <numeric>
+#include <vector>
+
+#include "float8.h"
+
+int main() {
+    std::vector<float8_t> data(1000);
+    std::vector<float> expected(data.size());
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = uchar_to_float8((unsigned char)(i * 7));
+        expected[i] = float8_to_float(data[i]);
+    }
+
+    float8_view view(data.data(), data.size());
+
+    // Range-based for loop
+    size_t i = 0;
+    for (float f : view) {
+        assert(f == expected[i] || (f != f && expected[i] != expected[i]));
+        i++;
+    }
+    assert(i == view.size());
+
+    // Algorithms taking input iterators
+    std::vector<float> decoded(view.begin(), view.end());
+    assert(decoded.size() == data.size());
+    float8_view::iterator found = std::find(view.begin(), view.end(), expected[10]);
+    assert(found != view.end() && *found == expected[10]);
+    float sum = std::accumulate(view.begin(), view.end(), 0.0f, [](float a, float b) {
+        return b == b && b - b == 0 ? a + b : a;  // Skip infinity and NaN
+    });
+    float reference = 0.0f;
+    for (float f : expected) {
+        if (f == f && f - f == 0) reference += f;
+    }
+    assert(sum == reference);
+    assert(view.get()->decoded_blocks > 0);
+
+    printf("\n#################### All C++ float8 view tests PASSED! ####################\n\n");
+    return 0;
+}
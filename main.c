@@ -21,12 +21,38 @@
 char f8_to_f32_csv[] = "float8_to_float32_tests/1-4-3.csv";
 char f32_to_f8_csv[] = "float32_to_float8_tests/1-4-3.csv";
 
+#ifdef FLOAT8_NO_FPU
+/*
+ * The library is built without its floating-point functions.
+ * The tests validate the integer-only functions in their place.
+ */
+static float8_t float_to_float8(float f) {
+    uint32_t bits;
+    memcpy(&bits, &f, sizeof(bits));
+    return float_bits_to_float8(bits);
+}
+
+static float float8_to_float(float8_t f8) {
+    uint32_t bits = float8_to_float_bits(f8);
+    float f;
+    memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+#endif
+
 /************************************************************
  *                   FUNCTION PROTOTYPES                    *
  ************************************************************/
 
 void float8_to_float32_test();
 void float32_to_float8_test();
+void fixed_point_test();
+void float8_view_test();
+void error_diffusion_test();
+void arena_test();
+void integer_only_test();
+void ocp_fp8_test();
+uint8_t ocp_reference(uint32_t bits, int e4m3, int saturate);
 unsigned char binaryStringToByte(const char *binaryString);
 
 /************************************************************
@@ -37,6 +63,14 @@ int main() {
     // Test the library for errors
     float8_to_float32_test();
     float32_to_float8_test();
+    fixed_point_test();
+    arena_test();
+    ocp_fp8_test();
+#ifndef FLOAT8_NO_FPU
+    integer_only_test();
+    float8_view_test();
+    error_diffusion_test();
+#endif
 
     return 0;
 }
@@ -151,6 +185,476 @@ void float32_to_float8_test() {
     printf("\n#################### All float32 to float8 tests PASSED! ####################\n\n");
 }
 
+/*
+ * Test the conversions between fixed-point integers and float8. It validates
+ * the correct functionality of the int_to_float8 and float8_to_int functions
+ * and of their array variants.
+ *
+ * Every 16-bit integer is converted with int_to_float8 and compared with the
+ * float_to_float8 conversion of the same value, and with saturation
+ * overflow must give the largest finite float8 number. Every float8 number is
+ * converted with float8_to_int and compared with the rounded float8_to_float
+ * value. The array variants are compared with the scalar functions.
+ * Integers wider than 24 bits are compared with hand-computed 1-4-3 values.
+ */
+void fixed_point_test() {
+    int frac_bits_list[] = {0, 4, 8, 15};
+    for (int k = 0; k < 4; k++) {
+        int frac_bits = frac_bits_list[k];
+
+        // Integer to float8
+        for (int32_t i = INT16_MIN; i <= INT16_MAX; i++) {
+            float floatValue = (float)i / (float)(1 << frac_bits);
+            unsigned char expected = float8_to_uchar(float_to_float8(floatValue));
+            assert(float8_to_uchar(int_to_float8(i, frac_bits, FLOAT8_OVERFLOW)) == expected);
+
+            // Saturation replaces infinity by the largest finite float8 number of the same sign
+            float8_t saturated = int_to_float8(i, frac_bits, FLOAT8_SATURATE);
+            if (float_to_float8(floatValue).exponent == (1 << EXPONENT_BITS) - 1) {
+                assert(saturated.sign == (i < 0));
+                assert(saturated.exponent == (1 << EXPONENT_BITS) - 2);
+                assert(saturated.fraction == (1 << (7 - EXPONENT_BITS)) - 1);
+            } else {
+                assert(float8_to_uchar(saturated) == expected);
+            }
+        }
+
+        // Float8 to integer
+        for (int i = 0; i < 256; i++) {
+            float f = float8_to_float(uchar_to_float8((unsigned char)i));
+            double scaled = (double)f * (double)(1 << frac_bits);
+            int64_t expected;
+            if (scaled >= 2147483647.0) {
+                expected = INT32_MAX;
+            } else if (scaled <= -2147483648.0) {
+                expected = INT32_MIN;
+            } else {
+                expected = scaled < 0 ? -(int64_t)(-scaled + 0.5) : (int64_t)(scaled + 0.5);
+            }
+            assert(float8_to_int(uchar_to_float8((unsigned char)i), frac_bits) == expected);
+        }
+
+        // Array variants
+        float8_t f8[256];
+        int8_t i8[256];
+        uint8_t u8[256];
+        int16_t i16[256];
+        int32_t i32[256];
+        for (int i = 0; i < 256; i++) {
+            f8[i] = uchar_to_float8((unsigned char)i);
+        }
+        float8_to_int8_array(f8, i8, 256, frac_bits);
+        float8_to_uint8_array(f8, u8, 256, frac_bits);
+        float8_to_int16_array(f8, i16, 256, frac_bits);
+        float8_to_int32_array(f8, i32, 256, frac_bits);
+        for (int i = 0; i < 256; i++) {
+            int32_t v = float8_to_int(f8[i], frac_bits);
+            assert(i8[i] == (v < INT8_MIN ? INT8_MIN : (v > INT8_MAX ? INT8_MAX : v)));
+            assert(u8[i] == (v < 0 ? 0 : (v > UINT8_MAX ? UINT8_MAX : v)));
+            assert(i16[i] == (v < INT16_MIN ? INT16_MIN : (v > INT16_MAX ? INT16_MAX : v)));
+            assert(i32[i] == v);
+        }
+        for (int i = 0; i < 256; i++) {
+            i8[i] = (int8_t)(i - 128);
+            u8[i] = (uint8_t)i;
+            i16[i] = (int16_t)(i * 257 - 32768);
+            i32[i] = (int32_t)((uint32_t)i * 0x01010101u);
+        }
+        int8_to_float8_array(i8, f8, 256, frac_bits, FLOAT8_OVERFLOW);
+        for (int i = 0; i < 256; i++) {
+            assert(float8_to_uchar(f8[i]) == float8_to_uchar(int_to_float8(i8[i], frac_bits, FLOAT8_OVERFLOW)));
+        }
+        int8_to_float8_array(i8, f8, 256, frac_bits, FLOAT8_SATURATE);
+        for (int i = 0; i < 256; i++) {
+            assert(float8_to_uchar(f8[i]) == float8_to_uchar(int_to_float8(i8[i], frac_bits, FLOAT8_SATURATE)));
+            assert(f8[i].exponent != (1 << EXPONENT_BITS) - 1);
+        }
+        uint8_to_float8_array(u8, f8, 256, frac_bits, FLOAT8_OVERFLOW);
+        for (int i = 0; i < 256; i++) {
+            assert(float8_to_uchar(f8[i]) == float8_to_uchar(int_to_float8(u8[i], frac_bits, FLOAT8_OVERFLOW)));
+        }
+        uint8_to_float8_array(u8, f8, 256, frac_bits, FLOAT8_SATURATE);
+        for (int i = 0; i < 256; i++) {
+            assert(float8_to_uchar(f8[i]) == float8_to_uchar(int_to_float8(u8[i], frac_bits, FLOAT8_SATURATE)));
+        }
+        int16_to_float8_array(i16, f8, 256, frac_bits, FLOAT8_OVERFLOW);
+        for (int i = 0; i < 256; i++) {
+            assert(float8_to_uchar(f8[i]) == float8_to_uchar(int_to_float8(i16[i], frac_bits, FLOAT8_OVERFLOW)));
+        }
+        int16_to_float8_array(i16, f8, 256, frac_bits, FLOAT8_SATURATE);
+        for (int i = 0; i < 256; i++) {
+            assert(float8_to_uchar(f8[i]) == float8_to_uchar(int_to_float8(i16[i], frac_bits, FLOAT8_SATURATE)));
+        }
+        int32_to_float8_array(i32, f8, 256, frac_bits, FLOAT8_OVERFLOW);
+        for (int i = 0; i < 256; i++) {
+            assert(float8_to_uchar(f8[i]) == float8_to_uchar(int_to_float8(i32[i], frac_bits, FLOAT8_OVERFLOW)));
+        }
+    }
+
+#if EXPONENT_BITS == 4
+    // Integers wider than 24 bits, with set bits below the 24 most significant ones
+    assert(float8_to_uchar(int_to_float8(0x7FFFFFFF, 0, FLOAT8_OVERFLOW)) == 0x78);   // +inf
+    assert(float8_to_uchar(int_to_float8(0x7FFFFFFF, 0, FLOAT8_SATURATE)) == 0x77);   // +240
+    assert(float8_to_uchar(int_to_float8(0x7FFFFFFF, 28, FLOAT8_OVERFLOW)) == 0x50);  // +8
+    assert(float8_to_uchar(int_to_float8(INT32_MIN, 0, FLOAT8_OVERFLOW)) == 0xF8);    // -inf
+    assert(float8_to_uchar(int_to_float8(INT32_MIN, 0, FLOAT8_SATURATE)) == 0xF7);    // -240
+    assert(float8_to_uchar(int_to_float8(INT32_MIN, 31, FLOAT8_OVERFLOW)) == 0xB8);   // -1
+    assert(float8_to_uchar(int_to_float8(0x01080001, 24, FLOAT8_OVERFLOW)) == 0x38);  // +1
+    assert(float8_to_uchar(int_to_float8(0x01080001, 20, FLOAT8_OVERFLOW)) == 0x58);  // +16
+    // Rounding to float32 first would carry into the rounding bit and give 0x39 (+1.125)
+    assert(float8_to_uchar(int_to_float8(0x087FFFFF, 27, FLOAT8_OVERFLOW)) == 0x38);  // +1
+#endif
+    printf("\n#################### All fixed-point tests PASSED! ####################\n\n");
+}
+
+#ifndef FLOAT8_NO_FPU
+/*
+ * Test the lazy float32 view of a float8 array. It validates the correct
+ * functionality of the float8_view_get, float8_view_span and
+ * float8_to_float_array functions.
+ *
+ * A buffer of float8 numbers is decoded with float8_to_float_array and
+ * read through views with and without prefetching, both sequentially
+ * in spans and in a scattered order. Every value read must be equal to
+ * the float8_to_float conversion of the same float8 number.
+ */
+void float8_view_test() {
+    enum { LENGTH = 1000 };
+    float8_t data[LENGTH];
+    float expected[LENGTH];
+    for (int i = 0; i < LENGTH; i++) {
+        data[i] = uchar_to_float8((unsigned char)(i * 7));
+        expected[i] = float8_to_float(data[i]);
+    }
+
+    float decoded[LENGTH];
+    float8_to_float_array(data, decoded, LENGTH);
+    assert(memcmp(decoded, expected, sizeof(expected)) == 0);
+
+    for (int prefetch = 0; prefetch <= 1; prefetch++) {
+        float8_view_t view;
+        float8_view_init(&view, data, LENGTH, prefetch);
+
+        // Sequential scan
+        size_t i = 0;
+        while (i < LENGTH) {
+            const float *span;
+            size_t count = float8_view_span(&view, i, &span);
+            assert(count >= 1 && i + count <= LENGTH);
+            assert(memcmp(span, &expected[i], count * sizeof(float)) == 0);
+            i += count;
+        }
+        assert(view.decoded_blocks == (LENGTH + FLOAT8_VIEW_BLOCK_SIZE - 1) / FLOAT8_VIEW_BLOCK_SIZE);
+
+        // Scattered access
+        for (size_t k = 0; k < 4 * LENGTH; k++) {
+            size_t index = (k * 337) % LENGTH;
+            float f = float8_view_get(&view, index);
+            assert(memcmp(&f, &expected[index], sizeof(float)) == 0);
+        }
+
+        // Random access decodes only the blocks it misses, one per access here
+        float8_view_init(&view, data, LENGTH, prefetch);
+        size_t blocks = (LENGTH + FLOAT8_VIEW_BLOCK_SIZE - 1) / FLOAT8_VIEW_BLOCK_SIZE;
+        for (size_t k = 0; k < blocks; k++) {
+            size_t block = (k * 5) % blocks;
+            float f = float8_view_get(&view, block * FLOAT8_VIEW_BLOCK_SIZE);
+            assert(memcmp(&f, &expected[block * FLOAT8_VIEW_BLOCK_SIZE], sizeof(float)) == 0);
+            assert(view.decoded_blocks == k + 1);
+        }
+    }
+    printf("\n#################### All float8 view tests PASSED! ####################\n\n");
+}
+
+/*
+ * Test the error-diffusion quantization. It validates the correct
+ * functionality of the float_to_float8_sd function.
+ *
+ * A slowly varying interleaved stream of three channels is converted in
+ * a single call and in chunks of varying size. Both conversions must give
+ * the same float8 numbers, and the sum of the converted values of every
+ * channel must stay close to the sum of its input values. A stream covering
+ * every float32 exponent, infinity and NaN is compared with a reference that
+ * uses the float_to_float8 and float8_to_float functions.
+ */
+void error_diffusion_test() {
+    enum { CHANNELS = 3, FRAMES = 500, LENGTH = CHANNELS * FRAMES };
+    float src[LENGTH];
+    for (int i = 0; i < FRAMES; i++) {
+        src[i * CHANNELS + 0] = 0.3f;
+        src[i * CHANNELS + 1] = -0.7f + 0.001f * i;
+        src[i * CHANNELS + 2] = 0.01f + 0.0005f * (i % 100);
+    }
+
+    // Single call
+    float residual[CHANNELS];
+    float8_sd_state_t state;
+    float8_t whole[LENGTH];
+    assert(float8_sd_init(&state, residual, CHANNELS) == 0);
+    float_to_float8_sd(&state, src, whole, LENGTH);
+
+    // Chunked calls
+    float8_t chunked[LENGTH];
+    float8_sd_init(&state, residual, CHANNELS);
+    size_t i = 0;
+    for (size_t chunk = 1; i < LENGTH; chunk = chunk % 11 + 1) {
+        size_t count = LENGTH - i < chunk ? LENGTH - i : chunk;
+        float_to_float8_sd(&state, &src[i], &chunked[i], count);
+        i += count;
+    }
+    assert(memcmp(whole, chunked, sizeof(whole)) == 0);
+
+    // Zero channels are rejected and nothing is converted
+    memcpy(chunked, whole, sizeof(whole));
+    assert(float8_sd_init(&state, residual, 0) == -1);
+    float_to_float8_sd(&state, src, chunked, LENGTH);
+    assert(memcmp(whole, chunked, sizeof(whole)) == 0);
+
+    // Accumulated error
+    for (int c = 0; c < CHANNELS; c++) {
+        double error = 0;
+        for (int k = 0; k < FRAMES; k++) {
+            error += src[k * CHANNELS + c] - float8_to_float(whole[k * CHANNELS + c]);
+        }
+        assert(error < 0.5 && error > -0.5);
+    }
+
+    // Reference quantizer over the whole float32 range
+    enum { WIDE_CHANNELS = 8, WIDE_LENGTH = 65536 };
+    static float wide_src[WIDE_LENGTH];
+    static float8_t wide_dst[WIDE_LENGTH];
+    float wide_residual[WIDE_CHANNELS];
+    float reference_residual[WIDE_CHANNELS] = {0};
+    for (uint32_t k = 0; k < WIDE_LENGTH; k++) {
+        uint32_t bits = (k << 16) | ((k * 0x9E37u) & 0xFFFF);
+        memcpy(&wide_src[k], &bits, sizeof(float));
+    }
+    assert(float8_sd_init(&state, wide_residual, WIDE_CHANNELS) == 0);
+    float_to_float8_sd(&state, wide_src, wide_dst, WIDE_LENGTH);
+    for (int k = 0; k < WIDE_LENGTH; k++) {
+        float *r = &reference_residual[k % WIDE_CHANNELS];
+        float value = wide_src[k] + *r;
+        float8_t expected = float_to_float8(value);
+        *r = expected.exponent == (1 << EXPONENT_BITS) - 1 ? 0 : value - float8_to_float(expected);
+        assert(float8_to_uchar(wide_dst[k]) == float8_to_uchar(expected));
+    }
+    assert(memcmp(wide_residual, reference_residual, sizeof(wide_residual)) == 0);
+    printf("\n#################### All error diffusion tests PASSED! ####################\n\n");
+}
+#endif
+
+/*
+ * Test the aligned buffer arenas. It validates the correct functionality
+ * of the float8_arena_* functions.
+ *
+ * Buffers are allocated until the arena is full. Every buffer must be
+ * aligned and must not overlap the previous one. After a reset the arena
+ * must hand out the same memory again, and the statistics must count
+ * every allocation, failure and reset.
+ */
+void arena_test() {
+    int flags_list[] = {0, FLOAT8_ARENA_PREFAULT | FLOAT8_ARENA_HUGEPAGES};
+    for (int k = 0; k < 2; k++) {
+        float8_arena_t arena;
+        assert(float8_arena_init(&arena, 4096, flags_list[k]) == 0);
+
+        float8_t *first = float8_arena_alloc_float8(&arena, 100);
+        assert(first != NULL && (uintptr_t)first % FLOAT8_ALIGNMENT == 0);
+        float *second = float8_arena_alloc_float(&arena, 100);
+        assert(second != NULL && (uintptr_t)second % FLOAT8_ALIGNMENT == 0);
+        assert((unsigned char *)second >= (unsigned char *)(first + 100));
+
+        // Fill and convert the buffers to check that they are usable
+        for (int i = 0; i < 100; i++) first[i] = uchar_to_float8((unsigned char)i);
+        for (int i = 0; i < 100; i++) second[i] = float8_to_float(first[i]);
+        assert(second[99] == float8_to_float(first[99]));
+
+        // The arena is full after 4096 bytes
+        assert(float8_arena_alloc(&arena, 4096) == NULL);
+        assert(float8_arena_alloc_float(&arena, SIZE_MAX) == NULL);
+        assert(float8_arena_alloc(&arena, 0) == NULL);
+        assert(arena.stats.allocations == 2 && arena.stats.failures == 2);
+        assert(arena.stats.bytes_in_use == 128 + 448);
+
+        // Reset and reuse the same memory
+        float8_arena_reset(&arena);
+        assert(float8_arena_alloc_float8(&arena, 4096) == first);
+        assert(arena.stats.resets == 1 && arena.stats.bytes_in_use == 4096);
+        assert(arena.stats.peak_bytes_in_use == 4096);
+
+        float8_arena_destroy(&arena);
+    }
+
+    // Arenas of at least one huge page start on a huge page boundary
+    float8_arena_t arena;
+    assert(float8_arena_init(&arena, 4 * 1024 * 1024, FLOAT8_ARENA_HUGEPAGES) == 0);
+    assert((uintptr_t)arena.start % (2 * 1024 * 1024) == 0);
+    float8_arena_destroy(&arena);
+    printf("\n#################### All arena tests PASSED! ####################\n\n");
+}
+
+/*
+ * Test the OCP FP8 conversions. It validates the correct functionality of
+ * the E4M3FN and E5M2 encoders and decoders.
+ *
+ * Every FP8 number is decoded and encoded back. Float32 numbers are encoded
+ * for every value of the upper 16 bits of the bit pattern, combined with
+ * lower bits that cover the rounding cases, and compared with a reference
+ * that searches the nearest FP8 number. Known values of the OCP
+ * specification are also checked.
+ */
+void ocp_fp8_test() {
+    for (int saturate = 0; saturate <= 1; saturate++) {
+        // Round trip of every FP8 number
+        for (int i = 0; i < 256; i++) {
+            uint32_t bits = e4m3fn_to_float_bits((uint8_t)i);
+            if ((i & 0x7F) == 0x7F) {  // NaN
+                assert((bits & 0x7FFFFFFF) > 0x7F800000);
+            }
+            assert(float_bits_to_e4m3fn(bits, saturate) == i);
+
+            bits = e5m2_to_float_bits((uint8_t)i);
+            if ((i & 0x7F) > 0x7C) {  // NaN
+                assert((bits & 0x7FFFFFFF) > 0x7F800000);
+                assert(float_bits_to_e5m2(bits, saturate) == ((i & 0x80) | 0x7E));
+            } else if ((i & 0x7F) == 0x7C) {  // Infinity
+                assert((bits & 0x7FFFFFFF) == 0x7F800000);
+                assert(float_bits_to_e5m2(bits, saturate) == (saturate ? (i & 0x80) | 0x7B : i));
+            } else {
+                assert(float_bits_to_e5m2(bits, saturate) == i);
+            }
+        }
+
+        // Nearest FP8 number
+        uint32_t low_bits[] = {0x0000, 0x0001, 0x7FFF, 0x8000, 0xFFFF};
+        for (uint32_t high = 0; high <= 0xFFFF; high++) {
+            for (int k = 0; k < 5; k++) {
+                uint32_t bits = (high << 16) | low_bits[k];
+                assert(float_bits_to_e4m3fn(bits, saturate) == ocp_reference(bits, 1, saturate));
+                assert(float_bits_to_e5m2(bits, saturate) == ocp_reference(bits, 0, saturate));
+            }
+        }
+    }
+
+    // Known values
+    float values[] = {448.0f, 464.0f, 465.0f, 57344.0f, 61440.0f, 1.0625f, 1.1875f, 0.001953125f};
+    uint32_t bits[8];
+    memcpy(bits, values, sizeof(bits));
+    assert(float_bits_to_e4m3fn(bits[0], FLOAT8_OVERFLOW) == 0x7E);
+    assert(float_bits_to_e4m3fn(bits[1], FLOAT8_OVERFLOW) == 0x7E);
+    assert(float_bits_to_e4m3fn(bits[2], FLOAT8_OVERFLOW) == 0x7F);
+    assert(float_bits_to_e4m3fn(bits[2] | 0x80000000, FLOAT8_SATURATE) == 0xFE);
+    assert(float_bits_to_e4m3fn(0x7F800000, FLOAT8_SATURATE) == 0x7E);
+    assert(float_bits_to_e4m3fn(bits[5], FLOAT8_OVERFLOW) == 0x38);
+    assert(float_bits_to_e4m3fn(bits[6], FLOAT8_OVERFLOW) == 0x3A);
+    assert(float_bits_to_e4m3fn(bits[7], FLOAT8_OVERFLOW) == 0x01);
+    assert(e4m3fn_to_float_bits(0x7E) == bits[0]);
+    assert(float_bits_to_e5m2(bits[3], FLOAT8_OVERFLOW) == 0x7B);
+    assert(float_bits_to_e5m2(bits[4], FLOAT8_OVERFLOW) == 0x7C);
+    assert(float_bits_to_e5m2(bits[4], FLOAT8_SATURATE) == 0x7B);
+    assert(e5m2_to_float_bits(0x7B) == bits[3]);
+    assert(e5m2_to_float_bits(0xFC) == 0xFF800000);
+
+#ifndef FLOAT8_NO_FPU
+    // Floating-point and array variants
+    uint8_t codes[256];
+    float decoded[256];
+    uint8_t encoded[256];
+    for (int i = 0; i < 256; i++) codes[i] = (uint8_t)i;
+    e4m3fn_to_float_array(codes, decoded, 256);
+    float_to_e4m3fn_array(decoded, encoded, 256, FLOAT8_SATURATE);
+    for (int i = 0; i < 256; i++) {
+        assert(memcmp(&decoded[i], &(float){e4m3fn_to_float(codes[i])}, sizeof(float)) == 0);
+        assert(encoded[i] == float_to_e4m3fn(decoded[i], FLOAT8_SATURATE));
+    }
+    e5m2_to_float_array(codes, decoded, 256);
+    float_to_e5m2_array(decoded, encoded, 256, FLOAT8_OVERFLOW);
+    for (int i = 0; i < 256; i++) {
+        assert(memcmp(&decoded[i], &(float){e5m2_to_float(codes[i])}, sizeof(float)) == 0);
+        assert(encoded[i] == float_to_e5m2(decoded[i], FLOAT8_OVERFLOW));
+    }
+#endif
+    printf("\n#################### All OCP FP8 tests PASSED! ####################\n\n");
+}
+
+/*
+ * Reference OCP FP8 encoder. Searches the finite FP8 number nearest to the
+ * float, preferring the even code on ties. A value nearer to the number
+ * above the largest finite one is an overflow.
+ *
+ * @param bits: bit pattern of the single-precision floating point number
+ * @param e4m3: non-zero for E4M3FN, zero for E5M2
+ * @param saturate: FLOAT8_SATURATE or FLOAT8_OVERFLOW
+ * @return: FP8 number
+ */
+uint8_t ocp_reference(uint32_t bits, int e4m3, int saturate) {
+    uint8_t sign = (bits >> 24) & 0x80;
+    int max_finite = e4m3 ? 0x7E : 0x7B;
+    uint8_t overflow = e4m3 ? 0x7F : 0x7C;
+    uint8_t nan = e4m3 ? 0x7F : 0x7E;
+    uint32_t abs = bits & 0x7FFFFFFF;
+    if (abs > 0x7F800000) return sign | nan;
+    if (abs == 0x7F800000) return sign | (saturate ? max_finite : overflow);
+
+    // Values of the positive finite codes, and of the code above the largest finite one
+    double values[128];
+    for (int code = 0; code <= max_finite; code++) {
+        uint32_t value_bits = e4m3 ? e4m3fn_to_float_bits((uint8_t)code) : e5m2_to_float_bits((uint8_t)code);
+        float value;
+        memcpy(&value, &value_bits, sizeof(value));
+        values[code] = value;
+    }
+    values[max_finite + 1] = 2 * values[max_finite] - values[max_finite - 1];
+
+    float f;
+    memcpy(&f, &abs, sizeof(f));
+    if (f >= values[max_finite + 1]) return sign | (saturate ? max_finite : overflow);
+    int best = 0;
+    for (int code = 1; code <= max_finite + 1; code++) {
+        double error = values[code] > f ? values[code] - f : f - values[code];
+        double best_error = values[best] > f ? values[best] - f : f - values[best];
+        if (error < best_error || (error == best_error && (code & 0x1) == 0)) {
+            best = code;
+        }
+    }
+    if (best > max_finite) return sign | (saturate ? max_finite : overflow);
+    return sign | (uint8_t)best;
+}
+
+#ifndef FLOAT8_NO_FPU
+/*
+ * Test the integer-only conversions. It validates that the float_bits_to_float8
+ * and float8_to_float_bits functions are bit-exact with the float_to_float8
+ * and float8_to_float functions.
+ *
+ * Every float8 number is converted to float32. Float32 numbers are converted
+ * to float8 for every value of the upper 16 bits of the bit pattern,
+ * combined with lower bits that cover the rounding cases.
+ */
+void integer_only_test() {
+    for (int i = 0; i < 256; i++) {
+        float8_t f8 = uchar_to_float8((unsigned char)i);
+        float f = float8_to_float(f8);
+        uint32_t bits;
+        memcpy(&bits, &f, sizeof(bits));
+        assert(float8_to_float_bits(f8) == bits);
+    }
+
+    uint32_t low_bits[] = {0x0000, 0x0001, 0x7FFF, 0x8000, 0xFFFF};
+    for (uint32_t high = 0; high <= 0xFFFF; high++) {
+        for (int k = 0; k < 5; k++) {
+            uint32_t bits = (high << 16) | low_bits[k];
+            float f;
+            memcpy(&f, &bits, sizeof(f));
+            unsigned char expected = float8_to_uchar(float_to_float8(f));
+            assert(float8_to_uchar(float_bits_to_float8(bits)) == expected);
+        }
+    }
+    printf("\n#################### All integer-only tests PASSED! ####################\n\n");
+}
+
+#endif
+
 /*
  * Convert a binary string to an unsigned char.
  *